@@ -16,3 +16,10 @@ else
     echo " Ошибка компиляции"
     exit 1
 fi
+
+# Тесты поискового индекса (база данных не нужна); замер времени: ./search_index_test bench
+g++ -o search_index_test search_index_test.cpp -O2 -std=c++11 -Wall -Wextra && ./search_index_test
+if [ $? -ne 0 ]; then
+    echo " Тесты поискового индекса не прошли"
+    exit 1
+fi
@@ -3,22 +3,470 @@
 #include <vector>
 #include <libpq-fe.h>
 #include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <poll.h>
+#include "product_search_index.h"
 
 using namespace std;
 
+// Параметры подключения к БД
+struct DBConfig {
+    string conninfo;         // строка подключения libpq
+    int connectTimeoutMs;    // время ожидания одной попытки подключения
+    int connectRetries;      // количество попыток подключения (0 - без ограничения)
+
+    DBConfig() : conninfo("host=localhost dbname=furniture_store user=postgres password=123456"),
+                 connectTimeoutMs(5000), connectRetries(10) {}
+};
+
+// убираем пробелы, табуляцию и \r (файлы с концами строк CRLF) по краям
+static string trimSetting(const string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// разбор целого числа не меньше minValue; false, если значение некорректно
+static bool parseSettingInt(const string& value, int minValue, int& result) {
+    char* end = NULL;
+    long parsed = strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || parsed < minValue || parsed > 2147483647L) {
+        return false;
+    }
+    result = static_cast<int>(parsed);
+    return true;
+}
+
+// применяем одну настройку вида ключ=значение, source - откуда она взята (для сообщений)
+static void applyDBSetting(DBConfig& config, const string& rawKey, const string& rawValue,
+                           const string& source) {
+    string key = trimSetting(rawKey);
+    string value = trimSetting(rawValue);
+    bool valid = true;
+    if (key == "conninfo") {
+        valid = !value.empty();
+        if (valid) config.conninfo = value;
+    } else if (key == "connect_timeout_ms") {
+        valid = parseSettingInt(value, 1, config.connectTimeoutMs);      // таймаут должен быть > 0
+    } else if (key == "connect_retries") {
+        valid = parseSettingInt(value, 0, config.connectRetries);        // 0 - без ограничения
+    } else {
+        cerr << source << ": unknown setting '" << key << "' ignored" << endl;
+        return;
+    }
+    if (!valid) {
+        cerr << source << ": invalid value '" << value << "' for " << key
+             << ", keeping the previous value" << endl;
+    }
+}
+
+// Загрузка настроек: значения по умолчанию, затем файл
+// (FURNITURE_STORE_CONFIG или furniture_store.conf), затем переменные окружения.
+// Ключи файла: conninfo, connect_timeout_ms, connect_retries
+// (пример с описанием - furniture_store.conf.example);
+// переменные окружения: FURNITURE_STORE_CONNINFO, FURNITURE_STORE_CONNECT_TIMEOUT_MS,
+// FURNITURE_STORE_CONNECT_RETRIES
+DBConfig loadDBConfig() {
+    DBConfig config;
+
+    const char* envPath = getenv("FURNITURE_STORE_CONFIG");
+    string path = envPath != NULL ? envPath : "furniture_store.conf";
+    ifstream file(path.c_str());
+    if (envPath != NULL && !file) {
+        cerr << "Cannot open config file " << path << ", using defaults" << endl;
+    }
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        lineNumber++;
+        string trimmed = trimSetting(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;  // пропускаем пустые строки и комментарии
+        string source = path + ":" + to_string(lineNumber);
+        size_t eq = trimmed.find('=');
+        if (eq == string::npos) {
+            cerr << source << ": expected key=value, line ignored" << endl;
+            continue;
+        }
+        // делим по первому '=', так как в conninfo тоже есть '='
+        applyDBSetting(config, trimmed.substr(0, eq), trimmed.substr(eq + 1), source);
+    }
+
+    const char* envNames[3][2] = {
+        {"FURNITURE_STORE_CONNINFO", "conninfo"},
+        {"FURNITURE_STORE_CONNECT_TIMEOUT_MS", "connect_timeout_ms"},
+        {"FURNITURE_STORE_CONNECT_RETRIES", "connect_retries"}
+    };
+    for (int i = 0; i < 3; i++) {
+        const char* value = getenv(envNames[i][0]);
+        if (value != NULL) {
+            applyDBSetting(config, envNames[i][1], value, envNames[i][0]);
+        }
+    }
+    return config;
+}
+
+// Ожидание готовности сокета соединения, не дольше deadline
+static bool waitForSocket(PGconn* conn, bool forWrite, chrono::steady_clock::time_point deadline) {
+    int sock = PQsocket(conn);
+    long long leftMs = chrono::duration_cast<chrono::milliseconds>(
+        deadline - chrono::steady_clock::now()).count();
+    if (sock < 0 || leftMs <= 0) {
+        return false;
+    }
+    pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = forWrite ? POLLOUT : POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, static_cast<int>(leftMs)) > 0;
+}
+
+// Завершение неблокирующего подключения: опрашиваем PQconnectPoll (или PQresetPoll
+// при переподключении), пока соединение не установится или не истечет таймаут
+static bool pollConnection(PGconn* conn, bool reset, int timeoutMs) {
+    chrono::steady_clock::time_point deadline =
+        chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+    PostgresPollingStatusType status = PGRES_POLLING_WRITING;  // так требует libpq для первого шага
+    while (status != PGRES_POLLING_OK) {
+        if (status == PGRES_POLLING_FAILED ||
+            !waitForSocket(conn, status == PGRES_POLLING_WRITING, deadline)) {
+            return false;
+        }
+        status = reset ? PQresetPoll(conn) : PQconnectPoll(conn);
+    }
+    return true;
+}
+
+// Повтор действия с экспоненциальной задержкой между попытками (50 мс, 100 мс, ... до 2 с)
+static bool retryWithBackoff(const DBConfig& config, const function<bool()>& attempt) {
+    int delayMs = 50;
+    for (int i = 1; config.connectRetries == 0 || i <= config.connectRetries; i++) {
+        if (attempt()) {
+            return true;
+        }
+        if (i == config.connectRetries) {
+            break;  // после последней попытки не ждем
+        }
+        this_thread::sleep_for(chrono::milliseconds(delayMs));
+        delayMs = min(delayMs * 2, 2000);
+    }
+    return false;
+}
+
+// Одна попытка неблокирующего подключения, NULL при ошибке
+static PGconn* connectOnce(const DBConfig& config) {
+    PGconn* conn = PQconnectStart(config.conninfo.c_str());
+    if (conn != NULL && PQstatus(conn) != CONNECTION_BAD &&
+        pollConnection(conn, false, config.connectTimeoutMs)) {
+        return conn;
+    }
+    cerr << "Connection to database failed: "
+         << (conn != NULL ? PQerrorMessage(conn) : "out of memory") << endl;
+    PQfinish(conn);
+    return NULL;
+}
+
+// Одна попытка переподключения того же соединения (PQresetStart), false при ошибке
+static bool resetOnce(PGconn* conn, const DBConfig& config) {
+    if (PQresetStart(conn) && pollConnection(conn, true, config.connectTimeoutMs)) {
+        return true;
+    }
+    cerr << "Reconnect to database failed: " << PQerrorMessage(conn) << endl;
+    return false;
+}
+
 class FurnitureStoreDB {
 private:
     PGconn* connection; // указатель на соединение с БД, PGconn* - тип из libpq, хранит информацию о подключении
+    DBConfig config;    // параметры подключения (нужны для переподключения)
+    ProductSearchIndex searchIndex; // поисковый индекс товаров в памяти
+    
+    // SQL запрос для загрузки товаров в поисковый индекс
+    static const char* indexedProductsQuery() {
+        return "SELECT p.product_id, p.product_name, COALESCE(p.description, ''), p.price, "
+               "p.stock_quantity, COALESCE(p.category_id, 0), COALESCE(c.category_name, '') "
+               "FROM products p "
+               "LEFT JOIN categories c ON p.category_id = c.category_id ";  // LEFT JOIN - товары без категории тоже нужны
+    }
+    
+    // преобразуем строку результата запроса в товар для индекса
+    static IndexedProduct indexedProductFromRow(PGresult* res, int row) {
+        IndexedProduct product;
+        product.productId = atoi(PQgetvalue(res, row, 0));
+        product.productName = PQgetvalue(res, row, 1);
+        product.description = PQgetvalue(res, row, 2);
+        product.price = atof(PQgetvalue(res, row, 3));
+        product.stockQuantity = atoi(PQgetvalue(res, row, 4));
+        product.categoryId = atoi(PQgetvalue(res, row, 5));
+        product.categoryName = PQgetvalue(res, row, 6);
+        product.active = true;
+        return product;
+    }
+    
+    // подписка на уведомления об изменении товаров (см. триггер в schema.sql)
+    void listenProductChanges() {
+        PGresult* res = PQexec(connection, "LISTEN products_changed");
+        PQclear(res);
+    }
+    
+    // часто выполняемые запросы (сервер разбирает их один раз за сессию): имя и SQL,
+    // у каждого один параметр
+    static vector<pair<string, string> > preparedStatements() {
+        vector<pair<string, string> > statements;
+        statements.push_back(make_pair("check_stock",
+            "SELECT stock_quantity FROM products WHERE product_id = $1"));
+        statements.push_back(make_pair("product_price",
+            "SELECT price FROM products WHERE product_id = $1"));
+        statements.push_back(make_pair("indexed_products",
+            string(indexedProductsQuery()) + "WHERE p.product_id = ANY($1::int[])"));
+        return statements;
+    }
+    
+    static void reportPrepareResult(PGresult* res, const string& name, PGconn* conn) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+            cerr << "Failed to prepare " << name << ": " << PQerrorMessage(conn) << endl;
+        }
+    }
+    
+    void prepareStatements() {
+        vector<pair<string, string> > statements = preparedStatements();
+        for (size_t i = 0; i < statements.size(); i++) {
+            PGresult* res = PQprepare(connection, statements[i].first.c_str(),
+                                      statements[i].second.c_str(), 1, NULL);
+            reportPrepareResult(res, statements[i].first, connection);
+            PQclear(res);
+        }
+    }
+    
+    // загрузка всех товаров в поисковый индекс
+    void loadSearchIndex() {
+        PGresult* res = PQexec(connection, indexedProductsQuery());
+        fillSearchIndex(res);
+        PQclear(res);
+    }
+    
+    // заполнение индекса результатом запроса indexedProductsQuery()
+    bool fillSearchIndex(PGresult* res) {
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            cout << "Ошибка при загрузке поискового индекса." << endl;
+            return false;
+        }
+        vector<IndexedProduct> products;
+        int rows = PQntuples(res);
+        products.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            products.push_back(indexedProductFromRow(res, i));
+        }
+        searchIndex.assign(products);
+        return true;
+    }
+    
+    // обновление нескольких товаров в поисковом индексе одним запросом
+    void refreshIndexedProducts(const vector<int>& productIds) {
+        if (productIds.empty()) {
+            return;
+        }
+        // массив ID в текстовом формате PostgreSQL: {1,2,3}
+        string idsStr = "{";
+        for (size_t i = 0; i < productIds.size(); i++) {
+            if (i > 0) idsStr += ",";
+            idsStr += to_string(productIds[i]);
+        }
+        idsStr += "}";
+        const char* params[1] = {idsStr.c_str()};
+        
+        PGresult* res = execPrepared("indexed_products", 1, params);
+        
+        if (PQresultStatus(res) == PGRES_TUPLES_OK) {
+            vector<int> found;
+            int rows = PQntuples(res);
+            for (int i = 0; i < rows; i++) {
+                IndexedProduct product = indexedProductFromRow(res, i);
+                found.push_back(product.productId);
+                searchIndex.upsert(product);
+            }
+            // товары, которых нет в результате, удалены из БД
+            sort(found.begin(), found.end());
+            for (size_t i = 0; i < productIds.size(); i++) {
+                if (!binary_search(found.begin(), found.end(), productIds[i])) {
+                    searchIndex.remove(productIds[i]);
+                }
+            }
+        }
+        PQclear(res);
+    }
+    
+    // применение изменений товаров из уведомлений products_changed
+    void syncSearchIndex() {
+        // забираем уже пришедшие данные без блокировки
+        if (!PQconsumeInput(connection)) {
+            // соединение оборвалось: reconnect() заново подписывается и перезагружает индекс
+            if (PQstatus(connection) == CONNECTION_BAD) {
+                reconnect();
+            }
+            return;
+        }
+        vector<int> changedIds;
+        PGnotify* notify;
+        while ((notify = PQnotifies(connection)) != NULL) {
+            // в payload триггер передает product_id измененного товара;
+            // свои изменения (updateProductStock) индекс уже получил напрямую
+            int productId = atoi(notify->extra);
+            if (productId > 0 && notify->be_pid != PQbackendPID(connection)) {
+                changedIds.push_back(productId);
+            }
+            PQfreemem(notify);
+        }
+        // при массовом UPDATE приходит много уведомлений - убираем повторы
+        sort(changedIds.begin(), changedIds.end());
+        changedIds.erase(unique(changedIds.begin(), changedIds.end()), changedIds.end());
+        refreshIndexedProducts(changedIds);
+    }
+    
+#ifdef LIBPQ_HAS_PIPELINING
+    // Прогрев одним конвейером (pipeline, libpq 14+): LISTEN, подготовка запросов и
+    // загрузка индекса отправляются сразу, без ожидания ответа на каждую команду,
+    // поэтому вся подготовка занимает одну передачу данных до сервера и обратно.
+    // false - конвейер отправить не удалось или команда в нем не выполнилась,
+    // тогда команды нужно выполнить по очереди
+    bool warmUpPipelined() {
+        if (!PQenterPipelineMode(connection)) {
+            return false;
+        }
+        vector<pair<string, string> > statements = preparedStatements();
+        // LISTEN идет первым, чтобы не пропустить изменения товаров во время загрузки индекса
+        bool sent = PQsendQueryParams(connection, "LISTEN products_changed", 0, NULL, NULL, NULL, NULL, 0);
+        for (size_t i = 0; i < statements.size() && sent; i++) {
+            sent = PQsendPrepare(connection, statements[i].first.c_str(),
+                                 statements[i].second.c_str(), 1, NULL);
+        }
+        sent = sent && PQsendQueryParams(connection, indexedProductsQuery(), 0, NULL, NULL, NULL, NULL, 0);
+        sent = sent && PQpipelineSync(connection);
+
+        // ответы приходят в порядке отправки: LISTEN, PREPARE..., SELECT, затем PIPELINE_SYNC;
+        // результаты каждой команды заканчиваются NULL. После ошибки в одной из команд
+        // остальные до PIPELINE_SYNC приходят как PGRES_PIPELINE_ABORTED
+        bool ok = sent;
+        size_t commands = statements.size() + 2;
+        for (size_t i = 0; i < commands && sent; i++) {
+            PGresult* res;
+            while ((res = PQgetResult(connection)) != NULL) {
+                if (PQresultStatus(res) == PGRES_PIPELINE_ABORTED) {
+                    ok = false;
+                } else if (i > 0 && i <= statements.size()) {
+                    reportPrepareResult(res, statements[i - 1].first, connection);
+                } else if (i == commands - 1) {
+                    ok = fillSearchIndex(res) && ok;
+                }
+                PQclear(res);
+            }
+        }
+        // выйти из конвейера можно только после того, как прочитаны все результаты
+        // (включая PIPELINE_SYNC); два NULL подряд - результатов больше нет
+        int emptyResults = 0;
+        while (!PQexitPipelineMode(connection) && emptyResults < 2 &&
+               PQstatus(connection) == CONNECTION_OK) {
+            PGresult* res = PQgetResult(connection);
+            if (res == NULL) {
+                emptyResults++;
+                continue;
+            }
+            emptyResults = 0;
+            if (PQresultStatus(res) == PGRES_PIPELINE_ABORTED) {
+                ok = false;
+            }
+            PQclear(res);
+        }
+        return ok && PQpipelineStatus(connection) == PQ_PIPELINE_OFF;
+    }
+#endif
+    
+    // Прогрев сессии после (пере)подключения: подписка на уведомления,
+    // подготовленные запросы и загрузка поискового индекса
+    void warmUp() {
+#ifdef LIBPQ_HAS_PIPELINING
+        if (warmUpPipelined()) {
+            return;
+        }
+        // часть команд конвейера могла выполниться - подготовленные запросы создаем заново
+        PGresult* res = PQexec(connection, "DEALLOCATE ALL");
+        PQclear(res);
+#endif
+        // без конвейера (старая libpq или команда в нем не выполнилась) - выполняем команды по очереди
+        listenProductChanges();
+        prepareStatements();
+        loadSearchIndex();
+    }
+    
+    // Переподключение после обрыва соединения (перезапуск или переключение сервера БД)
+    bool reconnect() {
+        cerr << "Connection to database lost, reconnecting..." << endl;
+        // каждая неудачная попытка выводится в resetOnce (при connect_retries = 0 попытки не ограничены)
+        bool ok = retryWithBackoff(config, [this]() {
+            return resetOnce(connection, config);
+        });
+        if (!ok) {
+            cerr << "Could not reconnect to database after " << config.connectRetries << " attempts" << endl;
+            return false;
+        }
+        cout << "Reconnected to database." << endl;
+        // подписка и подготовленные запросы живут в рамках сессии, создаем их заново;
+        // индекс перезагружаем, так как уведомления во время обрыва потеряны
+        warmUp();
+        return true;
+    }
+    
+    // Выполнение запроса с переподключением при обрыве соединения.
+    // Повторно запрос отправляется только при retry = true: для INSERT и
+    // неидемпотентных UPDATE неизвестно, успел ли сервер его выполнить
+    PGresult* execParams(const string& query, int nParams, const char* const* params, bool retry) {
+        if (PQstatus(connection) == CONNECTION_BAD && !reconnect()) {
+            return NULL;  // PQresultStatus(NULL) == PGRES_FATAL_ERROR
+        }
+        PGresult* res = PQexecParams(connection, query.c_str(), nParams, NULL, params, NULL, NULL, 0);
+        if (PQstatus(connection) == CONNECTION_BAD && reconnect() && retry) {
+            PQclear(res);
+            res = PQexecParams(connection, query.c_str(), nParams, NULL, params, NULL, NULL, 0);
+        }
+        return res;
+    }
+    
+    // То же для подготовленных запросов (все они только читают данные, повтор безопасен)
+    PGresult* execPrepared(const char* name, int nParams, const char* const* params) {
+        if (PQstatus(connection) == CONNECTION_BAD && !reconnect()) {
+            return NULL;
+        }
+        PGresult* res = PQexecPrepared(connection, name, nParams, params, NULL, NULL, 0);
+        if (PQstatus(connection) == CONNECTION_BAD && reconnect()) {
+            PQclear(res);
+            res = PQexecPrepared(connection, name, nParams, params, NULL, NULL, 0);
+        }
+        return res;
+    }
     
 public:
     // Конструктор класса
-    FurnitureStoreDB(const string& conninfo) {
-        connection = PQconnectdb(conninfo.c_str());  // подключаемся к БД
-        if (PQstatus(connection) != CONNECTION_OK) { // проверяем успешность
-            cerr << "Connection to database failed: " << PQerrorMessage(connection) << endl;
-            exit(1);  // выходим при ошибке
+    FurnitureStoreDB(const DBConfig& dbConfig) : connection(NULL), config(dbConfig) {
+        // неблокирующее подключение с повторами, сервер БД может еще запускаться
+        bool ok = retryWithBackoff(config, [this]() {
+            connection = connectOnce(config);
+            return connection != NULL;
+        });
+        if (!ok) {
+            cerr << "Could not connect to database after " << config.connectRetries << " attempts" << endl;
+            exit(1);  // выходим, если все попытки исчерпаны
         }
         cout << "Connected to database successfully!" << endl;
+        
+        warmUp();
     }
     
     // Деструктор класса
@@ -42,15 +490,11 @@ public:
         };
         
         // выполняем параметризованный запрос к базе данных
-        PGresult* res = PQexecParams(connection,  // соединение с БД
-                                     query.c_str(),  // SQL запрос
-                                     5,  // количество параметров
-                                     NULL,  // типы параметров (автоопределение)
-                                     params,  // массив значений параметров
-                                     NULL,  // длины параметров
-                                     NULL,  // форматы параметров
-                                     0  // формат результата (0=текст, 1=бинарный)
-                                    );
+        PGresult* res = execParams(query,  // SQL запрос
+                                   5,  // количество параметров
+                                   params,  // массив значений параметров
+                                   false  // INSERT не повторяем при обрыве соединения
+                                  );
         
         // проверяем успешность выполнения команды
         bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
@@ -76,8 +520,7 @@ public:
         const char* params[1] = {catIdStr.c_str()};
         
         // выполняем запрос с параметром
-        PGresult* res = PQexecParams(connection, query.c_str(), 1, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 1, params, true);
         
         // проверяем успешность выполнения запроса с возвратом данных
         if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -111,8 +554,7 @@ public:
         const char* params[2] = {clientIdStr.c_str(), shippingAddress.c_str()};
         
         // выполняем запрос
-        PGresult* res = PQexecParams(connection, query.c_str(), 2, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 2, params, false);
         
         // инициализируем orderId значением -1 (ошибка по умолчанию)
         int orderId = -1;
@@ -138,14 +580,12 @@ public:
             return false;  // если товара недостаточно, возвращаем false
         }
         
-        // получаем текущую цену товара из базы данных
-        string priceQuery = "SELECT price FROM products WHERE product_id = $1";
+        // получаем текущую цену товара из базы данных (подготовленный запрос product_price)
         string prodIdStr = to_string(productId);
         const char* priceParams[1] = {prodIdStr.c_str()};
         
         // выполняем запрос для получения цены
-        PGresult* priceRes = PQexecParams(connection, priceQuery.c_str(), 1, NULL, 
-                                          priceParams, NULL, NULL, 0);
+        PGresult* priceRes = execPrepared("product_price", 1, priceParams);
         
         // проверяем успешность запроса и наличие товара
         if (PQresultStatus(priceRes) != PGRES_TUPLES_OK || PQntuples(priceRes) == 0) {
@@ -177,8 +617,7 @@ public:
         };
         
         // Выполняем запрос добавления товара в заказ
-        PGresult* res = PQexecParams(connection, query.c_str(), 4, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 4, params, false);
         
         // Проверяем успешность выполнения команды
         bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
@@ -212,8 +651,7 @@ public:
         const char* params[2] = {orderIdStr.c_str(), orderIdStr.c_str()};
         
         // выполняем запрос обновления
-        PGresult* res = PQexecParams(connection, query.c_str(), 2, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 2, params, true);
         PQclear(res);
     }
     
@@ -231,9 +669,10 @@ public:
         const char* params[2] = {qtyStr.c_str(), prodIdStr.c_str()};
         
         // выполняем запрос обновления
-        PGresult* res = PQexecParams(connection, query.c_str(), 2, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 2, params, false);
         PQclear(res);
+        // обновляем остаток в поисковом индексе
+        refreshIndexedProducts(vector<int>(1, productId));
     }
     
     // 7. Метод: Получение статистики продаж
@@ -256,7 +695,7 @@ public:
             "ORDER BY total_revenue DESC";  // сортируем по выручке (убывание)
         
         // Выполняем запрос (без параметров)
-        PGresult* res = PQexec(connection, query.c_str());
+        PGresult* res = execParams(query, 0, NULL, true);
         
         // Проверяем успешность выполнения
         if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -308,8 +747,7 @@ public:
         const char* params[1] = {limitStr.c_str()};
         
         // выполняем параметризованный запрос
-        PGresult* res = PQexecParams(connection, query.c_str(), 1, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 1, params, true);
         
         // проверяем успешность выполнения
         if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -344,8 +782,7 @@ public:
         const char* params[2] = {status.c_str(), orderIdStr.c_str()};
         
         // выполняем запрос
-        PGresult* res = PQexecParams(connection, query.c_str(), 2, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 2, params, true);
         
         // проверяем успешность выполнения команды
         bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
@@ -378,8 +815,7 @@ public:
         const char* params[1] = {orderIdStr.c_str()};
         
         // выполняем запрос
-        PGresult* res = PQexecParams(connection, query.c_str(), 1, NULL, params, 
-                                     NULL, NULL, 0);
+        PGresult* res = execParams(query, 1, params, true);
         
         // проверяем успешность выполнения
         if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -421,16 +857,12 @@ public:
     
     // 11. Метод: Проверка наличия товара на складе
     bool checkStock(int productId, int requestedQuantity) {
-        // SQL запрос для получения остатка товара
-        string query = "SELECT stock_quantity FROM products WHERE product_id = $1";
-        
         // подготавливаем параметр
         string prodIdStr = to_string(productId);
         const char* params[1] = {prodIdStr.c_str()};
         
-        // выполняем запрос
-        PGresult* res = PQexecParams(connection, query.c_str(), 1, NULL, params, 
-                                     NULL, NULL, 0);
+        // выполняем подготовленный запрос check_stock (остаток товара)
+        PGresult* res = execPrepared("check_stock", 1, params);
         
         bool available = false;  // результат проверки (по умолчанию false)
         // проверяем успешность выполнения и наличие результата
@@ -454,7 +886,7 @@ public:
             "HAVING COUNT(*) > 1";  // фильтруем группы с количеством > 1
         
         // выполняем запрос (без параметров)
-        PGresult* res = PQexec(connection, query.c_str());
+        PGresult* res = execParams(query, 0, NULL, true);
         
         // проверяем успешность выполнения
         if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -483,7 +915,7 @@ public:
             "FROM clients ORDER BY client_id";  // сортируем по ID клиента
         
         // выполняем запрос
-        PGresult* res = PQexec(connection, query.c_str());
+        PGresult* res = execParams(query, 0, NULL, true);
         
         // проверяем успешность выполнения
         if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -516,6 +948,36 @@ public:
         }
         PQclear(res);
     }
+
+    // 14. Метод: Поиск товаров по названию и описанию (по индексу, без запроса к БД)
+    void searchProductsByName(const string& text, const ProductSearchFilter& filter) {
+        syncSearchIndex();
+
+        // замеряем время поиска по индексу
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<ProductSearchHit> hits = searchIndex.search(text, filter);
+        long long micros = chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now() - start).count();
+
+        if (hits.empty()) {
+            cout << "\nТовары не найдены." << endl;
+            return;
+        }
+        cout << "\nНайденные товары" << endl;
+        for (size_t i = 0; i < hits.size(); i++) {
+            const IndexedProduct& p = *hits[i].product;
+            // форматируем цену отдельно, чтобы не менять настройки cout
+            ostringstream price;
+            price << fixed << setprecision(2) << p.price;
+            cout << "ID: " << p.productId
+                 << ", Название: " << p.productName
+                 << ", Цена: " << price.str()
+                 << ", В наличии: " << p.stockQuantity
+                 << ", Категория: " << p.categoryName
+                 << endl;
+        }
+        cout << "Найдено: " << hits.size() << " (поиск занял " << micros << " мкс)" << endl;
+    }
 };
 
 void displayMenu() {
@@ -531,14 +993,14 @@ void displayMenu() {
     cout << "9. Проверить наличие товара" << endl;
     cout << "10. Найти дубликаты email" << endl;
     cout << "11. Показать всех клиентов" << endl;
+    cout << "12. Поиск товаров по названию" << endl;
     cout << "0. Выход" << endl;
     cout << "Выберите действие: ";
 }
 
 int main() {
-    // подключение к базе данных
-    string conninfo = "host=localhost dbname=furniture_store user=postgres password=123456";
-    FurnitureStoreDB db(conninfo);
+    // подключение к базе данных (настройки из furniture_store.conf и переменных окружения)
+    FurnitureStoreDB db(loadDBConfig());
     
     int choice;
     do {
@@ -673,6 +1135,27 @@ int main() {
                 db.showAllClients();
                 break;
                 
+            case 12: {
+                // Поиск товаров по названию и описанию
+                string text;
+                ProductSearchFilter filter;
+                int inStock;
+                cout << "Название или описание товара: ";
+                getline(cin, text);
+                cout << "ID категории (0 - любая): ";
+                cin >> filter.categoryId;
+                cout << "Только в наличии (1 - да, 0 - нет): ";
+                cin >> inStock;
+                filter.inStockOnly = (inStock == 1);
+                cout << "Минимальная цена (0 - без ограничения): ";
+                cin >> filter.minPrice;
+                cout << "Максимальная цена (0 - без ограничения): ";
+                cin >> filter.maxPrice;
+                
+                db.searchProductsByName(text, filter);
+                break;
+            }
+                
             case 0:
                 cout << "Выход из программы..." << endl;
                 break;
@@ -0,0 +1,582 @@
+#ifndef PRODUCT_SEARCH_INDEX_H
+#define PRODUCT_SEARCH_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+
+// Товар в поисковом индексе (копия нужных полей из таблицы products)
+struct IndexedProduct {
+    int productId;
+    std::string productName;
+    std::string description;
+    double price;
+    int stockQuantity;
+    int categoryId;          // 0, если категория не задана (NULL)
+    std::string categoryName;
+    bool active;             // false - товар удален из индекса
+};
+
+// Фильтры для поиска по названию
+struct ProductSearchFilter {
+    int categoryId;          // 0 - любая категория
+    bool inStockOnly;        // только товары с stock_quantity > 0
+    double minPrice;         // 0 - без нижней границы
+    double maxPrice;         // 0 - без верхней границы
+
+    ProductSearchFilter() : categoryId(0), inStockOnly(false), minPrice(0), maxPrice(0) {}
+};
+
+// Результат поиска: позиция товара в индексе и его оценка
+struct ProductSearchHit {
+    const IndexedProduct* product;
+    double score;
+};
+
+// Поисковый индекс по названию и описанию товаров в памяти.
+// Текст приводится к нижнему регистру (кириллица, включая украинские, белорусские и
+// другие буквы, латиница с диакритикой Latin-1 и Latin Extended-A, ё -> е),
+// разбивается на слова, для каждого слова строятся триграммы вида " ди", "див", "ван", "ан ".
+// Для каждой триграммы хранится отсортированный список товаров (postings),
+// поэтому запрос не обращается к PostgreSQL.
+class ProductSearchIndex {
+private:
+    std::vector<IndexedProduct> products;           // все товары, позиция в векторе - номер документа
+    std::unordered_map<int, int> positionById;      // product_id -> номер документа
+    std::vector<std::vector<std::vector<uint32_t> > > nameWords;   // нормализованные слова названия
+    std::vector<std::vector<std::vector<uint32_t> > > textWords;   // нормализованные слова названия и описания
+    std::unordered_map<uint64_t, std::vector<int> > postings;      // триграмма -> номера документов (название и описание)
+    std::unordered_map<uint64_t, std::vector<int> > namePostings;  // то же только по названию
+    std::vector<int> hitCounts;                     // счетчики совпавших триграмм (переиспользуются между запросами)
+    std::vector<int> positionsByPrice;              // номера документов по возрастанию цены (поддерживается в upsert)
+
+    // декодируем UTF-8 в последовательность кодов символов
+    static std::vector<uint32_t> decodeUtf8(const std::string& text) {
+        std::vector<uint32_t> result;
+        result.reserve(text.size());
+        size_t i = 0;
+        while (i < text.size()) {
+            unsigned char c = text[i];
+            uint32_t code;
+            int extra;
+            if (c < 0x80) { code = c; extra = 0; }
+            else if ((c & 0xE0) == 0xC0) { code = c & 0x1F; extra = 1; }
+            else if ((c & 0xF0) == 0xE0) { code = c & 0x0F; extra = 2; }
+            else if ((c & 0xF8) == 0xF0) { code = c & 0x07; extra = 3; }
+            else { i++; continue; }  // некорректный байт пропускаем
+            if (i + extra >= text.size()) {
+                break;  // обрезанная последовательность в конце строки
+            }
+            for (int k = 1; k <= extra; k++) {
+                code = (code << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+            }
+            result.push_back(code);
+            i += extra + 1;
+        }
+        return result;
+    }
+
+    // в блоках, где заглавная и строчная буквы идут парами (Ā ā, Ѣ ѣ, Ґ ґ ...),
+    // заглавная стоит на четной или нечетной позиции в зависимости от диапазона
+    static uint32_t pairedLower(uint32_t c) {
+        bool upperEven = (c >= 0x0100 && c <= 0x0137) || (c >= 0x014A && c <= 0x0177) ||
+                         (c >= 0x0460 && c <= 0x0481) || (c >= 0x048A && c <= 0x04BF) ||
+                         (c >= 0x04D0 && c <= 0x052F);
+        bool upperOdd = (c >= 0x0139 && c <= 0x0148) || (c >= 0x0179 && c <= 0x017E) ||
+                        (c >= 0x04C1 && c <= 0x04CE);
+        if ((upperEven && c % 2 == 0) || (upperOdd && c % 2 == 1)) {
+            return c + 1;
+        }
+        return c;
+    }
+
+    // нормализация одного символа: нижний регистр, ё -> е, разделители -> 0
+    static uint32_t normalizeChar(uint32_t c) {
+        if (c >= 'A' && c <= 'Z') return c + 32;                 // латиница
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) return c;
+        if (c == 0x00D7 || c == 0x00F7) return 0;                // знаки × и ÷
+        if (c >= 0x00C0 && c <= 0x00DE) return c + 0x20;         // À-Þ -> à-þ
+        if (c >= 0x00DF && c <= 0x00FF) return c;                // ß, à-ÿ
+        if (c == 0x0130) return 'i';                             // İ
+        if (c == 0x0178) return 0x00FF;                          // Ÿ -> ÿ
+        if (c >= 0x0100 && c <= 0x024F) return pairedLower(c);   // латиница с диакритикой
+        if (c >= 0x0400 && c <= 0x040F) c += 0x50;               // Ѐ-Џ (Ё, Є, І, Ї, Ў ...) -> ѐ-џ
+        else if (c >= 0x0410 && c <= 0x042F) c += 0x20;          // А-Я -> а-я
+        if (c == 0x0451) return 0x0435;                          // ё -> е
+        if (c >= 0x0430 && c <= 0x045F) return c;                // а-я, ѐ-џ (украинские, белорусские, сербские буквы)
+        if (c >= 0x0482 && c <= 0x0489) return 0;                // кириллические знаки, не буквы
+        if (c == 0x04C0) return 0x04CF;                          // Ӏ -> ӏ
+        if (c >= 0x0460 && c <= 0x052F) return pairedLower(c);   // остальная кириллица (Ґ, Ғ, Қ, Ң, Ү ...)
+        return 0;                                                 // пробелы и знаки препинания
+    }
+
+    // разбиваем текст на нормализованные слова
+    static std::vector<std::vector<uint32_t> > splitWords(const std::string& text) {
+        std::vector<std::vector<uint32_t> > words;
+        std::vector<uint32_t> current;
+        std::vector<uint32_t> codes = decodeUtf8(text);
+        for (size_t i = 0; i < codes.size(); i++) {
+            uint32_t c = normalizeChar(codes[i]);
+            if (c == 0) {
+                if (!current.empty()) {
+                    words.push_back(current);
+                    current.clear();
+                }
+            } else {
+                current.push_back(c);
+            }
+        }
+        if (!current.empty()) {
+            words.push_back(current);
+        }
+        return words;
+    }
+
+    // упаковываем три символа (по 21 бит) в одно 64-битное число
+    static uint64_t packTrigram(uint32_t a, uint32_t b, uint32_t c) {
+        return (static_cast<uint64_t>(a) << 42) | (static_cast<uint64_t>(b) << 21) | c;
+    }
+
+    // триграммы одного слова; closed = false для последнего слова запроса,
+    // которое пользователь еще набирает (поиск по префиксу).
+    // Дополнительно для каждого слова хранится ключ его первой буквы,
+    // чтобы запрос из одной буквы тоже отвечался по индексу
+    static void addWordTrigrams(const std::vector<uint32_t>& word, bool closed, bool isQuery, std::vector<uint64_t>& out) {
+        if (!isQuery || (!closed && word.size() == 1)) {
+            out.push_back(packTrigram(0, ' ', word[0]));
+        }
+        std::vector<uint32_t> padded;
+        padded.push_back(' ');
+        padded.insert(padded.end(), word.begin(), word.end());
+        if (closed) {
+            padded.push_back(' ');
+        }
+        for (size_t i = 0; i + 2 < padded.size(); i++) {
+            out.push_back(packTrigram(padded[i], padded[i + 1], padded[i + 2]));
+        }
+    }
+
+    // уникальные триграммы слов товара
+    static std::vector<uint64_t> productTrigrams(const std::vector<std::vector<uint32_t> >& words) {
+        std::vector<uint64_t> trigrams;
+        for (size_t i = 0; i < words.size(); i++) {
+            addWordTrigrams(words[i], true, false, trigrams);
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+
+    // проверяем, что каждое слово запроса является началом какого-либо слова текста
+    static bool matchesPrefixes(const std::vector<std::vector<uint32_t> >& queryWords,
+                                const std::vector<std::vector<uint32_t> >& words) {
+        for (size_t q = 0; q < queryWords.size(); q++) {
+            bool found = false;
+            for (size_t w = 0; w < words.size() && !found; w++) {
+                found = words[w].size() >= queryWords[q].size() &&
+                        std::equal(queryWords[q].begin(), queryWords[q].end(), words[w].begin());
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool passesFilter(const IndexedProduct& product, const ProductSearchFilter& filter) {
+        if (!product.active) return false;
+        if (filter.categoryId != 0 && product.categoryId != filter.categoryId) return false;
+        if (filter.inStockOnly && product.stockQuantity <= 0) return false;
+        if (filter.minPrice > 0 && product.price < filter.minPrice) return false;
+        if (filter.maxPrice > 0 && product.price > filter.maxPrice) return false;
+        return true;
+    }
+
+    // списки держим отсортированными, чтобы пересекать их и искать в них двоичным поиском
+    static void insertPostings(std::unordered_map<uint64_t, std::vector<int> >& index,
+                               const std::vector<uint64_t>& trigrams, int position) {
+        for (size_t i = 0; i < trigrams.size(); i++) {
+            std::vector<int>& list = index[trigrams[i]];
+            list.insert(std::lower_bound(list.begin(), list.end(), position), position);
+        }
+    }
+
+    static void erasePostings(std::unordered_map<uint64_t, std::vector<int> >& index,
+                              const std::vector<uint64_t>& trigrams, int position) {
+        for (size_t i = 0; i < trigrams.size(); i++) {
+            std::unordered_map<uint64_t, std::vector<int> >::iterator it = index.find(trigrams[i]);
+            if (it == index.end()) continue;
+            std::vector<int>& list = it->second;
+            std::vector<int>::iterator found = std::lower_bound(list.begin(), list.end(), position);
+            if (found != list.end() && *found == position) {
+                list.erase(found);
+            }
+            if (list.empty()) {
+                index.erase(it);
+            }
+        }
+    }
+
+    void addPostings(int position) {
+        const IndexedProduct& product = products[position];
+        nameWords[position] = splitWords(product.productName);
+        textWords[position] = splitWords(product.productName + " " + product.description);
+        insertPostings(postings, productTrigrams(textWords[position]), position);
+        insertPostings(namePostings, productTrigrams(nameWords[position]), position);
+    }
+
+    void removePostings(int position) {
+        erasePostings(postings, productTrigrams(textWords[position]), position);
+        erasePostings(namePostings, productTrigrams(nameWords[position]), position);
+    }
+
+    // списки товаров для найденных в индексе триграмм, от коротких к длинным
+    static std::vector<const std::vector<int>*> findLists(const std::unordered_map<uint64_t, std::vector<int> >& index,
+                                                const std::vector<uint64_t>& trigrams) {
+        std::vector<const std::vector<int>*> lists;
+        for (size_t t = 0; t < trigrams.size(); t++) {
+            std::unordered_map<uint64_t, std::vector<int> >::const_iterator it = index.find(trigrams[t]);
+            if (it != index.end()) {
+                lists.push_back(&it->second);
+            }
+        }
+        std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) {
+            return a->size() < b->size();
+        });
+        return lists;
+    }
+
+    // товары, которые есть во всех списках (начинаем с самого короткого)
+    static std::vector<int> intersectLists(const std::vector<const std::vector<int>*>& lists) {
+        std::vector<int> result;
+        if (lists.empty()) {
+            return result;
+        }
+        result = *lists[0];
+        for (size_t l = 1; l < lists.size() && !result.empty(); l++) {
+            const std::vector<int>& list = *lists[l];
+            std::vector<int> next;
+            if (result.size() * 16 < list.size()) {
+                // кандидатов мало - ищем их в длинном списке двоичным поиском
+                for (size_t k = 0; k < result.size(); k++) {
+                    if (std::binary_search(list.begin(), list.end(), result[k])) {
+                        next.push_back(result[k]);
+                    }
+                }
+            } else {
+                std::set_intersection(result.begin(), result.end(), list.begin(), list.end(),
+                                 std::back_inserter(next));
+            }
+            result.swap(next);
+        }
+        return result;
+    }
+
+    // оценка товара, у которого есть все триграммы начал слов запроса:
+    // 3 + доля триграмм при совпадении префиксов в названии, 2 + доля - в описании,
+    // иначе только доля (если она не меньше половины)
+    void classifyMatch(int position, bool inName, const std::vector<std::vector<uint32_t> >& queryWords,
+                       int prefixCount, const std::vector<const std::vector<int>*>& closingLists, int total,
+                       std::vector<ProductSearchHit>& nameHits, std::vector<ProductSearchHit>& textHits,
+                       std::vector<ProductSearchHit>& fuzzyHits) const {
+        // триграммы, закрывающие слова запроса, проверяем по их спискам
+        int count = prefixCount;
+        for (size_t l = 0; l < closingLists.size(); l++) {
+            if (std::binary_search(closingLists[l]->begin(), closingLists[l]->end(), position)) {
+                count++;
+            }
+        }
+        double ratio = static_cast<double>(count) / total;
+        ProductSearchHit hit = {&products[position], 0.0};
+        if (inName && matchesPrefixes(queryWords, nameWords[position])) {
+            hit.score = 3.0 + ratio;
+            nameHits.push_back(hit);
+        } else if (matchesPrefixes(queryWords, textWords[position])) {
+            hit.score = 2.0 + ratio;
+            textHits.push_back(hit);
+        } else if (2 * count >= total) {
+            hit.score = ratio;
+            fuzzyHits.push_back(hit);
+        }
+    }
+
+    // нечеткие совпадения: товары, в которых есть не меньше половины триграмм запроса;
+    // prefixMatches уже разобраны при поиске по префиксам
+    void appendFuzzyHits(const std::vector<const std::vector<int>*>& lists, int total,
+                         const std::vector<int>& prefixMatches,
+                         const ProductSearchFilter& filter, std::vector<ProductSearchHit>& hits) {
+        int minHits = (total + 1) / 2;
+        if (static_cast<int>(lists.size()) < minHits) {
+            return;  // ни один товар не наберет порог
+        }
+
+        // товар, которого нет ни в одном из первых (lists - minHits + 1) списков,
+        // не наберет minHits, поэтому кандидаты берутся только из них
+        std::vector<int> candidates;
+        size_t seedLists = lists.size() - minHits + 1;
+        for (size_t l = 0; l < lists.size(); l++) {
+            const std::vector<int>& list = *lists[l];
+            if (l < seedLists) {
+                for (size_t k = 0; k < list.size(); k++) {
+                    if (hitCounts[list[k]]++ == 0) {
+                        candidates.push_back(list[k]);
+                    }
+                }
+            } else if (candidates.size() * 16 < list.size()) {
+                for (size_t k = 0; k < candidates.size(); k++) {
+                    if (std::binary_search(list.begin(), list.end(), candidates[k])) {
+                        hitCounts[candidates[k]]++;
+                    }
+                }
+            } else {
+                for (size_t k = 0; k < list.size(); k++) {
+                    if (hitCounts[list[k]] > 0) {
+                        hitCounts[list[k]]++;
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            int position = candidates[i];
+            int count = hitCounts[position];
+            hitCounts[position] = 0;  // сбрасываем счетчик для следующего запроса
+            if (count < minHits || !passesFilter(products[position], filter) ||
+                std::binary_search(prefixMatches.begin(), prefixMatches.end(), position)) continue;
+            ProductSearchHit hit = {&products[position], static_cast<double>(count) / total};
+            hits.push_back(hit);
+        }
+    }
+
+    // место товара в positionsByPrice: после всех товаров с такой же или меньшей ценой
+    void insertPriceSlot(int position) {
+        const std::vector<IndexedProduct>& items = products;
+        positionsByPrice.insert(std::upper_bound(positionsByPrice.begin(), positionsByPrice.end(),
+                                                 items[position].price,
+                                                 [&items](double price, int other) { return price < items[other].price; }),
+                                position);
+    }
+
+    // убираем товар из positionsByPrice (цена в products[position] еще старая)
+    void erasePriceSlot(int position) {
+        const std::vector<IndexedProduct>& items = products;
+        std::vector<int>::iterator it = std::lower_bound(positionsByPrice.begin(), positionsByPrice.end(),
+                                                         items[position].price,
+                                                         [&items](int other, double price) { return items[other].price < price; });
+        while (it != positionsByPrice.end() && *it != position) {
+            ++it;  // среди товаров с той же ценой
+        }
+        if (it != positionsByPrice.end()) {
+            positionsByPrice.erase(it);
+        }
+    }
+
+    // сравнение результатов: оценка по убыванию, при равенстве - цена по возрастанию
+    static bool betterHit(const ProductSearchHit& a, const ProductSearchHit& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.product->price < b.product->price;
+    }
+
+public:
+    ProductSearchIndex() {}
+
+    // Полная очистка индекса перед загрузкой
+    void clear() {
+        products.clear();
+        positionById.clear();
+        nameWords.clear();
+        textWords.clear();
+        postings.clear();
+        namePostings.clear();
+        hitCounts.clear();
+        positionsByPrice.clear();
+    }
+
+    // Загрузка всего каталога: списки триграмм и порядок по цене строятся один раз,
+    // без вставки каждого товара в середину positionsByPrice
+    void assign(const std::vector<IndexedProduct>& items) {
+        clear();
+        products = items;
+        hitCounts.assign(products.size(), 0);
+        nameWords.resize(products.size());
+        textWords.resize(products.size());
+        positionsByPrice.resize(products.size());
+        for (size_t i = 0; i < products.size(); i++) {
+            int position = static_cast<int>(i);
+            products[i].active = true;
+            positionById[products[i].productId] = position;
+            positionsByPrice[i] = position;
+            addPostings(position);  // номера растут, поэтому вставка идет в конец списков
+        }
+        const std::vector<IndexedProduct>& sorted = products;
+        std::stable_sort(positionsByPrice.begin(), positionsByPrice.end(), [&sorted](int a, int b) {
+            return sorted[a].price < sorted[b].price;
+        });
+    }
+
+    // Добавление или обновление товара
+    void upsert(const IndexedProduct& product) {
+        std::unordered_map<int, int>::iterator it = positionById.find(product.productId);
+        if (it == positionById.end()) {
+            int position = static_cast<int>(products.size());
+            products.push_back(product);
+            products[position].active = true;
+            positionById[product.productId] = position;
+            hitCounts.push_back(0);
+            nameWords.push_back(std::vector<std::vector<uint32_t> >());
+            textWords.push_back(std::vector<std::vector<uint32_t> >());
+            addPostings(position);
+            insertPriceSlot(position);
+            return;
+        }
+
+        int position = it->second;
+        IndexedProduct& existing = products[position];
+        // если текст не изменился (например, поменялся только остаток), триграммы не перестраиваем
+        bool textChanged = !existing.active ||
+                           existing.productName != product.productName ||
+                           existing.description != product.description;
+        if (textChanged && existing.active) {
+            removePostings(position);
+        }
+        bool priceChanged = existing.price != product.price;
+        if (priceChanged) {
+            erasePriceSlot(position);
+        }
+        existing = product;
+        existing.active = true;
+        if (priceChanged) {
+            insertPriceSlot(position);
+        }
+        if (textChanged) {
+            addPostings(position);
+        }
+    }
+
+    // Удаление товара из индекса (позиция остается занятой, товар помечается неактивным)
+    void remove(int productId) {
+        std::unordered_map<int, int>::iterator it = positionById.find(productId);
+        if (it == positionById.end() || !products[it->second].active) {
+            return;
+        }
+        removePostings(it->second);
+        products[it->second].active = false;
+    }
+
+    // Поиск по префиксам слов и нечеткий поиск по доле совпавших триграмм.
+    // Совпадение по названию выше совпадения по описанию, нечеткие совпадения ниже всех.
+    // Каждое слово запроса может быть только началом слова товара, поэтому кандидаты
+    // для поиска по префиксам - пересечение списков триграмм без закрывающего пробела
+    // ("стол" в запросе "стол ж" находит "Столик"); триграммы вида "ол " влияют только на оценку.
+    // Нечеткий поиск выполняется, только если по префиксам нашлось меньше limit товаров.
+    std::vector<ProductSearchHit> search(const std::string& query, const ProductSearchFilter& filter, size_t limit = 20) {
+        std::vector<ProductSearchHit> hits;
+        std::vector<std::vector<uint32_t> > queryWords = splitWords(query);
+        if (queryWords.empty() || limit == 0) {
+            return hits;
+        }
+
+        // все триграммы запроса (для оценки) и триграммы начал его слов (для отбора кандидатов)
+        std::vector<uint64_t> trigrams, prefixTrigrams;
+        for (size_t i = 0; i < queryWords.size(); i++) {
+            addWordTrigrams(queryWords[i], i + 1 < queryWords.size(), true, trigrams);
+            addWordTrigrams(queryWords[i], false, true, prefixTrigrams);
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        std::sort(prefixTrigrams.begin(), prefixTrigrams.end());
+        prefixTrigrams.erase(std::unique(prefixTrigrams.begin(), prefixTrigrams.end()), prefixTrigrams.end());
+        int total = static_cast<int>(trigrams.size());
+
+        std::vector<uint64_t> closingTrigrams;
+        std::set_difference(trigrams.begin(), trigrams.end(), prefixTrigrams.begin(), prefixTrigrams.end(),
+                            std::back_inserter(closingTrigrams));
+        int prefixCount = total - static_cast<int>(closingTrigrams.size());
+        std::vector<const std::vector<int>*> closingLists = findLists(postings, closingTrigrams);
+
+        std::vector<const std::vector<int>*> textLists = findLists(postings, prefixTrigrams);
+        std::vector<const std::vector<int>*> nameLists = findLists(namePostings, prefixTrigrams);
+        std::vector<int> textMatches, nameMatches;
+        if (textLists.size() == prefixTrigrams.size()) {
+            textMatches = intersectLists(textLists);
+        }
+        if (nameLists.size() == prefixTrigrams.size()) {
+            nameMatches = intersectLists(nameLists);
+        }
+
+        // отметки в hitCounts: 1 - начала слов в названии или описании, 2 - в названии
+        for (size_t i = 0; i < textMatches.size(); i++) {
+            hitCounts[textMatches[i]] = 1;
+        }
+        for (size_t i = 0; i < nameMatches.size(); i++) {
+            hitCounts[nameMatches[i]] = 2;
+        }
+
+        // кандидатов разбираем по возрастанию цены и останавливаемся, когда limit товаров
+        // уже имеют наибольшую возможную оценку среди оставшихся (более дорогие товары
+        // с той же оценкой их не обгонят). Если под запрос подходит большая часть каталога,
+        // идем по общему порядку цен, иначе сортируем самих кандидатов
+        const std::vector<int>* order = &positionsByPrice;
+        std::vector<int> candidatesByPrice;
+        if (textMatches.size() * 8 <= products.size()) {
+            std::vector<std::pair<double, int> > priced;
+            priced.reserve(textMatches.size());
+            for (size_t i = 0; i < textMatches.size(); i++) {
+                priced.push_back(std::make_pair(products[textMatches[i]].price, textMatches[i]));
+            }
+            std::sort(priced.begin(), priced.end());
+            candidatesByPrice.reserve(priced.size());
+            for (size_t i = 0; i < priced.size(); i++) {
+                candidatesByPrice.push_back(priced[i].second);
+            }
+            order = &candidatesByPrice;
+        }
+
+        std::vector<ProductSearchHit> nameHits, textHits, fuzzyHits;
+        double bestRatio = static_cast<double>(prefixCount + closingLists.size()) / total;
+        double bestNameScore = 3.0 + bestRatio;
+        double bestTextScore = 2.0 + bestRatio;
+        size_t nameLeft = nameMatches.size();
+        size_t bestNameHits = 0, bestTextHits = 0;
+        for (size_t i = 0; i < order->size(); i++) {
+            if (nameLeft > 0 ? bestNameHits >= limit : nameHits.size() + bestTextHits >= limit) {
+                break;
+            }
+            int position = (*order)[i];
+            int mark = hitCounts[position];
+            if (mark == 0) continue;
+            if (mark == 2) nameLeft--;
+            if (!passesFilter(products[position], filter)) continue;
+            size_t nameBefore = nameHits.size(), textBefore = textHits.size();
+            classifyMatch(position, mark == 2, queryWords, prefixCount, closingLists, total,
+                          nameHits, textHits, fuzzyHits);
+            if (nameHits.size() > nameBefore && nameHits.back().score >= bestNameScore) bestNameHits++;
+            if (textHits.size() > textBefore && textHits.back().score >= bestTextScore) bestTextHits++;
+        }
+        for (size_t i = 0; i < textMatches.size(); i++) {
+            hitCounts[textMatches[i]] = 0;
+        }
+
+        hits.swap(nameHits);
+        hits.insert(hits.end(), textHits.begin(), textHits.end());
+        if (hits.size() < limit) {
+            hits.insert(hits.end(), fuzzyHits.begin(), fuzzyHits.end());
+            appendFuzzyHits(findLists(postings, trigrams), total, textMatches, filter, hits);
+        }
+
+        // сортируем только первые limit результатов
+        if (hits.size() > limit) {
+            std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), betterHit);
+            hits.resize(limit);
+        } else {
+            std::sort(hits.begin(), hits.end(), betterHit);
+        }
+        return hits;
+    }
+};
+
+#endif
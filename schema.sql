@@ -46,3 +46,32 @@ CREATE TABLE order_items (
     unit_price DECIMAL(10,2) NOT NULL,                                 --цена на момент заказа
     subtotal DECIMAL(10,2) GENERATED ALWAYS AS (quantity * unit_price) STORED  -- вычисляемое поле, GENERATED ALWAYS AS = значение всегда вычисляется по формуле (quantity * unit_price) = формула расчета, STORED = значение хранится в базе 
 );
+
+-- уведомление приложения об изменении товаров (для поискового индекса в памяти)
+CREATE OR REPLACE FUNCTION notify_products_changed() RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        PERFORM pg_notify('products_changed', OLD.product_id::text);  -- в payload передаем ID товара
+        RETURN OLD;
+    END IF;
+    PERFORM pg_notify('products_changed', NEW.product_id::text);
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER products_changed_trigger
+AFTER INSERT OR UPDATE OR DELETE ON products   -- срабатывает на любое изменение товара
+FOR EACH ROW EXECUTE FUNCTION notify_products_changed();
+
+-- при переименовании категории уведомляем о всех ее товарах (в индексе хранится название категории)
+CREATE OR REPLACE FUNCTION notify_category_products_changed() RETURNS TRIGGER AS $$
+BEGIN
+    PERFORM pg_notify('products_changed', product_id::text)
+    FROM products WHERE category_id = NEW.category_id;
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER categories_changed_trigger
+AFTER UPDATE OF category_name ON categories    -- удаление категории обновляет товары через ON DELETE SET NULL
+FOR EACH ROW EXECUTE FUNCTION notify_category_products_changed();
@@ -0,0 +1,445 @@
+// Проверка поискового индекса товаров (product_search_index.h) без базы данных.
+// Запуск: ./search_index_test - тесты, ./search_index_test bench - замер времени поиска
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include "product_search_index.h"
+
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " << #condition << endl; \
+            failures++; \
+        } \
+    } while (0)
+
+static IndexedProduct makeProduct(int id, const string& name, const string& description,
+                                  double price, int stock = 1, int categoryId = 1) {
+    IndexedProduct product;
+    product.productId = id;
+    product.productName = name;
+    product.description = description;
+    product.price = price;
+    product.stockQuantity = stock;
+    product.categoryId = categoryId;
+    product.categoryName = "";
+    product.active = true;
+    return product;
+}
+
+// ID найденных товаров в порядке выдачи
+static vector<int> searchIds(ProductSearchIndex& index, const string& query,
+                             const ProductSearchFilter& filter = ProductSearchFilter(), size_t limit = 20) {
+    vector<ProductSearchHit> hits = index.search(query, filter, limit);
+    vector<int> ids;
+    for (size_t i = 0; i < hits.size(); i++) {
+        ids.push_back(hits[i].product->productId);
+    }
+    return ids;
+}
+
+static bool contains(const vector<int>& ids, int id) {
+    return find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// ---------------------------------------------------------------------------
+// Эталон: прямой перебор всех товаров с той же оценкой, что и у индекса.
+// Нормализация и триграммы написаны заново, независимо от индекса.
+
+static vector<uint32_t> referenceDecode(const string& text) {
+    vector<uint32_t> codes;
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = text[i];
+        if (c < 0x80) {
+            codes.push_back(c);
+            i += 1;
+        } else if ((c & 0xE0) == 0xC0 && i + 1 < text.size()) {
+            codes.push_back(((c & 0x1F) << 6) | (static_cast<unsigned char>(text[i + 1]) & 0x3F));
+            i += 2;
+        } else {
+            i += 1;  // в тестовом словаре только 1- и 2-байтовые символы
+        }
+    }
+    return codes;
+}
+
+static vector<vector<uint32_t> > referenceWords(const string& text) {
+    vector<vector<uint32_t> > words(1);
+    vector<uint32_t> codes = referenceDecode(text);
+    for (size_t i = 0; i < codes.size(); i++) {
+        uint32_t c = codes[i];
+        if (c >= 'A' && c <= 'Z') c += 32;
+        else if (c >= 0x0410 && c <= 0x042F) c += 0x20;
+        if (c == 0x0401 || c == 0x0451) c = 0x0435;
+        bool letter = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || (c >= 0x0430 && c <= 0x044F);
+        if (letter) {
+            words.back().push_back(c);
+        } else if (!words.back().empty()) {
+            words.push_back(vector<uint32_t>());
+        }
+    }
+    if (words.back().empty()) {
+        words.pop_back();
+    }
+    return words;
+}
+
+// триграмма в виде строки из трех кодов; "\0 x" - ключ первой буквы слова
+static void referenceTrigrams(const vector<uint32_t>& word, bool closed, bool isQuery,
+                              vector<vector<uint32_t> >& out) {
+    if (!isQuery || (!closed && word.size() == 1)) {
+        vector<uint32_t> key;
+        key.push_back(0);
+        key.push_back(' ');
+        key.push_back(word[0]);
+        out.push_back(key);
+    }
+    vector<uint32_t> padded(1, ' ');
+    padded.insert(padded.end(), word.begin(), word.end());
+    if (closed) padded.push_back(' ');
+    for (size_t i = 0; i + 2 < padded.size(); i++) {
+        out.push_back(vector<uint32_t>(padded.begin() + i, padded.begin() + i + 3));
+    }
+}
+
+static bool referencePrefixes(const vector<vector<uint32_t> >& query, const vector<vector<uint32_t> >& words) {
+    for (size_t q = 0; q < query.size(); q++) {
+        bool found = false;
+        for (size_t w = 0; w < words.size() && !found; w++) {
+            found = words[w].size() >= query[q].size() &&
+                    equal(query[q].begin(), query[q].end(), words[w].begin());
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+struct ReferenceHit {
+    double score;
+    double price;
+};
+
+// название по префиксам: 3 + доля триграмм, описание: 2 + доля, иначе доля (не меньше 0.5)
+static vector<ReferenceHit> referenceSearch(const vector<IndexedProduct>& products, const string& query,
+                                            const ProductSearchFilter& filter, size_t limit) {
+    vector<ReferenceHit> hits;
+    vector<vector<uint32_t> > queryWords = referenceWords(query);
+    if (queryWords.empty()) return hits;
+    vector<vector<uint32_t> > queryTrigrams;
+    for (size_t i = 0; i < queryWords.size(); i++) {
+        referenceTrigrams(queryWords[i], i + 1 < queryWords.size(), true, queryTrigrams);
+    }
+    sort(queryTrigrams.begin(), queryTrigrams.end());
+    queryTrigrams.erase(unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+    for (size_t p = 0; p < products.size(); p++) {
+        const IndexedProduct& product = products[p];
+        if (!product.active) continue;
+        if (filter.categoryId != 0 && product.categoryId != filter.categoryId) continue;
+        if (filter.inStockOnly && product.stockQuantity <= 0) continue;
+        if (filter.minPrice > 0 && product.price < filter.minPrice) continue;
+        if (filter.maxPrice > 0 && product.price > filter.maxPrice) continue;
+
+        vector<vector<uint32_t> > nameWords = referenceWords(product.productName);
+        vector<vector<uint32_t> > textWords = referenceWords(product.productName + " " + product.description);
+        vector<vector<uint32_t> > productTrigrams;
+        for (size_t w = 0; w < textWords.size(); w++) {
+            referenceTrigrams(textWords[w], true, false, productTrigrams);
+        }
+        sort(productTrigrams.begin(), productTrigrams.end());
+        int common = 0;
+        for (size_t t = 0; t < queryTrigrams.size(); t++) {
+            if (binary_search(productTrigrams.begin(), productTrigrams.end(), queryTrigrams[t])) common++;
+        }
+        if (common == 0) continue;
+        double ratio = static_cast<double>(common) / queryTrigrams.size();
+
+        ReferenceHit hit = {0.0, product.price};
+        if (referencePrefixes(queryWords, nameWords)) hit.score = 3.0 + ratio;
+        else if (referencePrefixes(queryWords, textWords)) hit.score = 2.0 + ratio;
+        else if (ratio >= 0.5) hit.score = ratio;
+        else continue;
+        hits.push_back(hit);
+    }
+    sort(hits.begin(), hits.end(), [](const ReferenceHit& a, const ReferenceHit& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.price < b.price;
+    });
+    if (hits.size() > limit) hits.resize(limit);
+    return hits;
+}
+
+// ---------------------------------------------------------------------------
+
+static void testNormalization() {
+    ProductSearchIndex index;
+    index.upsert(makeProduct(1, "Шкаф-купе ЁЛКА", "", 100));
+    index.upsert(makeProduct(2, "Sofa COMFORT", "", 200));
+    index.upsert(makeProduct(3, "Кресло «Ёжик»", "", 300));
+
+    CHECK(searchIds(index, "елка") == vector<int>(1, 1));   // ё -> е, верхний регистр
+    CHECK(searchIds(index, "Ёлк") == vector<int>(1, 1));
+    CHECK(searchIds(index, "купе") == vector<int>(1, 1));   // дефис разделяет слова
+    CHECK(searchIds(index, "comf") == vector<int>(1, 2));   // латиница без учета регистра
+    CHECK(searchIds(index, "SOFA") == vector<int>(1, 2));
+    CHECK(searchIds(index, "ежик") == vector<int>(1, 3));   // кавычки - разделители
+
+    // латиница с диакритикой и кириллица за пределами русского алфавита
+    index.upsert(makeProduct(4, "CHAISE ÉLÉGANTE", "", 400));
+    index.upsert(makeProduct(5, "Ґанок Їжак Єнот", "", 500));
+    index.upsert(makeProduct(6, "Стол 120×60 ŁÓŻKO", "", 600));
+    CHECK(searchIds(index, "élégante") == vector<int>(1, 4));
+    CHECK(searchIds(index, "ÉLÉG") == vector<int>(1, 4));
+    CHECK(searchIds(index, "ґанок їжак") == vector<int>(1, 5));
+    CHECK(searchIds(index, "ЄНОТ") == vector<int>(1, 5));
+    CHECK(searchIds(index, "60") == vector<int>(1, 6));      // × - разделитель
+    CHECK(searchIds(index, "łóżko") == vector<int>(1, 6));
+
+    CHECK(searchIds(index, "").empty());
+    CHECK(searchIds(index, " ,.!").empty());
+}
+
+static void testPrefixAndFuzzyTiers() {
+    ProductSearchIndex index;
+    index.upsert(makeProduct(1, "Стол обеденный", "", 500));
+    index.upsert(makeProduct(2, "Столик журнальный", "", 900));
+    index.upsert(makeProduct(3, "Тумба", "Подходит к столу в гостиной", 100));
+    index.upsert(makeProduct(4, "Кровать двуспальная", "", 300));
+    index.upsert(makeProduct(5, "Диваны красные", "", 700));
+
+    // название выше описания, внутри группы - по цене
+    vector<int> ids = searchIds(index, "стол");
+    CHECK(ids.size() == 3 && ids[0] == 1 && ids[1] == 2 && ids[2] == 3);
+
+    // первое слово запроса - только начало слова товара ("стол" в "Столик")
+    ids = searchIds(index, "стол ж");
+    CHECK(!ids.empty() && ids[0] == 2);
+    ids = searchIds(index, "диван кр");
+    CHECK(!ids.empty() && ids[0] == 5);
+
+    // опечатка находится нечетким поиском
+    ids = searchIds(index, "кравать");
+    CHECK(ids.size() == 1 && ids[0] == 4);
+    vector<ProductSearchHit> hits = index.search("кравать", ProductSearchFilter(), 20);
+    CHECK(hits.size() == 1 && hits[0].score < 1.0);
+
+    // запрос из одной буквы
+    ids = searchIds(index, "к");
+    CHECK(contains(ids, 4) && contains(ids, 5) && !contains(ids, 1));
+
+    // limit
+    CHECK(searchIds(index, "стол", ProductSearchFilter(), 2).size() == 2);
+}
+
+static void testFilters() {
+    ProductSearchIndex index;
+    index.upsert(makeProduct(1, "Стул барный", "", 100, 0, 4));
+    index.upsert(makeProduct(2, "Стул офисный", "", 200, 5, 4));
+    index.upsert(makeProduct(3, "Стул детский", "", 300, 5, 2));
+
+    ProductSearchFilter filter;
+    filter.categoryId = 4;
+    vector<int> ids = searchIds(index, "стул", filter);
+    CHECK(ids.size() == 2 && !contains(ids, 3));
+
+    filter = ProductSearchFilter();
+    filter.inStockOnly = true;
+    ids = searchIds(index, "стул", filter);
+    CHECK(ids.size() == 2 && !contains(ids, 1));
+
+    filter = ProductSearchFilter();
+    filter.minPrice = 150;
+    filter.maxPrice = 250;
+    CHECK(searchIds(index, "стул", filter) == vector<int>(1, 2));
+}
+
+static void testUpsertAndRemove() {
+    ProductSearchIndex index;
+    index.upsert(makeProduct(1, "Комод", "", 100));
+    index.upsert(makeProduct(2, "Комод угловой", "", 200));
+
+    // переименование: старый текст больше не находится
+    index.upsert(makeProduct(1, "Тумба", "", 100));
+    CHECK(searchIds(index, "тумба") == vector<int>(1, 1));
+    CHECK(searchIds(index, "комод") == vector<int>(1, 2));
+
+    // изменение цены меняет порядок
+    index.upsert(makeProduct(3, "Комод белый", "", 300));
+    CHECK(searchIds(index, "комод") == vector<int>({2, 3}));
+    index.upsert(makeProduct(3, "Комод белый", "", 50));
+    CHECK(searchIds(index, "комод") == vector<int>({3, 2}));
+
+    // изменение остатка без изменения текста
+    IndexedProduct product = makeProduct(2, "Комод угловой", "", 200, 0);
+    index.upsert(product);
+    ProductSearchFilter inStock;
+    inStock.inStockOnly = true;
+    CHECK(searchIds(index, "комод", inStock) == vector<int>(1, 3));
+
+    // удаление и повторное добавление
+    index.remove(3);
+    CHECK(searchIds(index, "комод") == vector<int>(1, 2));
+    index.remove(3);  // повторное удаление ничего не ломает
+    index.upsert(makeProduct(3, "Комод белый", "", 50));
+    CHECK(searchIds(index, "комод") == vector<int>({3, 2}));
+
+    // полная перезагрузка заменяет весь каталог
+    vector<IndexedProduct> catalogue;
+    catalogue.push_back(makeProduct(7, "Комод высокий", "", 400));
+    catalogue.push_back(makeProduct(8, "Комод низкий", "", 150));
+    index.assign(catalogue);
+    CHECK(searchIds(index, "комод") == vector<int>({8, 7}));
+    CHECK(searchIds(index, "тумба").empty());
+    index.upsert(makeProduct(7, "Комод высокий", "", 100));
+    CHECK(searchIds(index, "комод") == vector<int>({7, 8}));
+}
+
+// Сравнение с эталоном на случайных каталогах и запросах
+static void testRankingMatchesReference() {
+    const char* words[] = {"Диван", "Диваны", "кровать", "Стол", "Столик", "стул", "шкаф", "кресло",
+                           "модель", "мягкий", "массив", "дуб", "дубовый", "comfort", "Lux", "угловой",
+                           "Ёлка", "журнальный", "красные", "кожаный", "белый"};
+    const int wordCount = sizeof(words) / sizeof(words[0]);
+    const char* queries[] = {"ди", "диван", "диван кр", "стол ж", "стол", "с", "дуб бел", "диван кож",
+                             "елк", "кравать", "comf", "стол дубов", "мяг див", "к", "ст м", "lux 1",
+                             "модель 12", "белый", "шкф", "кресло у"};
+    const int queryCount = sizeof(queries) / sizeof(queries[0]);
+
+    srand(12345);
+    int mismatches = 0;
+    for (int iteration = 0; iteration < 200; iteration++) {
+        ProductSearchIndex index;
+        vector<IndexedProduct> products;
+        int count = rand() % 300 + 1;
+        for (int i = 0; i < count; i++) {
+            string name = string(words[rand() % wordCount]) + " " + words[rand() % wordCount] +
+                          " " + to_string(rand() % 30);
+            string description = string(words[rand() % wordCount]) + ", " + words[rand() % wordCount];
+            products.push_back(makeProduct(i + 1, name, description, rand() % 200, rand() % 3, rand() % 4));
+            if (iteration % 2 == 0) {
+                index.upsert(products.back());
+            }
+        }
+        if (iteration % 2 == 1) {
+            index.assign(products);  // загрузка каталога целиком
+        }
+        // изменения после загрузки: переименование, цена, удаление
+        for (int k = 0; k < 5; k++) {
+            IndexedProduct& product = products[rand() % count];
+            product.productName = string(words[rand() % wordCount]) + " " + words[rand() % wordCount];
+            product.price = rand() % 200;
+            index.upsert(product);
+        }
+        for (int k = 0; k < 3; k++) {
+            IndexedProduct& product = products[rand() % count];
+            product.active = false;
+            index.remove(product.productId);
+        }
+
+        for (int q = 0; q < queryCount; q++) {
+            ProductSearchFilter filter;
+            if (rand() % 3 == 0) filter.categoryId = rand() % 4;
+            if (rand() % 3 == 0) filter.inStockOnly = true;
+            if (rand() % 4 == 0) filter.maxPrice = 100;
+            size_t limit = (rand() % 2 == 0) ? 20 : 5;
+
+            vector<ReferenceHit> expected = referenceSearch(products, queries[q], filter, limit);
+            vector<ProductSearchHit> actual = index.search(queries[q], filter, limit);
+            bool same = expected.size() == actual.size();
+            for (size_t i = 0; same && i < expected.size(); i++) {
+                same = expected[i].score == actual[i].score && expected[i].price == actual[i].product->price;
+            }
+            if (!same) {
+                if (mismatches < 3) {
+                    cerr << "ranking mismatch for \"" << queries[q] << "\": expected "
+                         << expected.size() << " hits, got " << actual.size() << endl;
+                    for (size_t i = 0; i < max(expected.size(), actual.size()); i++) {
+                        cerr << "  " << (i < expected.size() ? expected[i].score : -1) << " / "
+                             << (i < actual.size() ? actual[i].score : -1) << endl;
+                    }
+                }
+                mismatches++;
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// ---------------------------------------------------------------------------
+
+static long long bestMicros(ProductSearchIndex& index, const string& query, int repeats) {
+    long long best = -1;
+    for (int r = 0; r < repeats; r++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        index.search(query, ProductSearchFilter(), 20);
+        long long micros = chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now() - start).count();
+        if (best < 0 || micros < best) best = micros;
+    }
+    return best;
+}
+
+// Замер времени поиска на синтетическом каталоге
+static void runBenchmark(int productCount) {
+    const char* names[] = {"Диван", "Диваны", "Кровать", "Стол", "Столик", "Стул", "Шкаф", "Кресло",
+                           "Комод", "Тумба"};
+    const char* adjectives[] = {"кожаный", "дубовый", "белый", "красный", "угловой", "журнальный",
+                                "обеденный", "мягкий", "раскладной", "бельевой"};
+    const char* queries[] = {"д", "кр", "диван кож", "стол дубов", "дуб бел", "модель 123",
+                             "массив", "кравать", "кресло мяг", "шкаф б"};
+
+    srand(42);
+    ProductSearchIndex index;
+    vector<IndexedProduct> products;
+    for (int i = 0; i < productCount; i++) {
+        string name = string(names[rand() % 10]) + " " + adjectives[rand() % 10] + " модель " + to_string(i);
+        string description = string(adjectives[rand() % 10]) + ", из массива дерева";
+        products.push_back(makeProduct(i + 1, name, description, 1000 + rand() % 90000, rand() % 3, rand() % 5 + 1));
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    index.assign(products);
+    cout << productCount << " products loaded in "
+         << chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count()
+         << " ms" << endl;
+
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+        // первый запрос после загрузки отдельно от лучшего из повторов
+        cout << "  \"" << queries[q] << "\": first " << bestMicros(index, queries[q], 1)
+             << " us, best " << bestMicros(index, queries[q], 20) << " us" << endl;
+    }
+
+    // изменение цены не должно замедлять следующий запрос
+    IndexedProduct changed = products[productCount / 2];
+    changed.price = 1;
+    index.upsert(changed);
+    cout << "  \"д\" after price change: " << bestMicros(index, "д", 1) << " us" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "bench") {
+        runBenchmark(10000);
+        runBenchmark(100000);
+        return 0;
+    }
+
+    testNormalization();
+    testPrefixAndFuzzyTiers();
+    testFilters();
+    testUpsertAndRemove();
+    testRankingMatchesReference();
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << "All search index tests passed" << endl;
+    return 0;
+}